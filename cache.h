@@ -0,0 +1,216 @@
+#ifndef CACHE_H
+#define CACHE_H
+
+// On-disk result cache shared by the solvers.
+//
+// An instance is canonicalized by sorting its tasks on (length, weight,
+// deadline, is_in_S), so the same task set submitted in a different order
+// maps to the same entry. Entries are keyed by the solver name plus a 64-bit
+// FNV-1a hash of n, K, m and the sorted tasks, and store the canonical instance
+// itself so a hash collision is detected instead of served. Schedules are
+// stored as canonical indices and mapped back to the caller's task ids.
+//
+// File format (text):
+//   n K m
+//   length weight deadline is_in_S   (n lines, canonical order)
+//   s_count
+//   schedule                         (n canonical indices, if s_count != -1)
+//   machines                         (machine per position, if also m > 1)
+//
+// Updates are written to a temporary file and rename()d into place, so
+// concurrent processes sharing a cache directory never see a partial entry.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "task.h"
+
+#define CACHE_PATH_MAX 4096
+
+typedef struct {
+	char path[CACHE_PATH_MAX];
+	Task *sorted; // canonical order; sorted[i].id is the caller's task id
+	int n;
+	int K;
+	int m;
+} ResultCache;
+
+static int cache_compare_tasks(const void *a, const void *b)
+{
+	const Task *x = (const Task *)a;
+	const Task *y = (const Task *)b;
+
+	if (x->length != y->length)
+		return x->length < y->length ? -1 : 1;
+	if (x->weight != y->weight)
+		return x->weight < y->weight ? -1 : 1;
+	if (x->deadline != y->deadline)
+		return x->deadline < y->deadline ? -1 : 1;
+	return (int)x->is_in_S - (int)y->is_in_S;
+}
+
+static uint64_t cache_hash_int(uint64_t h, int value)
+{
+	uint32_t v = (uint32_t)value;
+
+	for (int i = 0; i < 4; i++) {
+		h ^= (v >> (8 * i)) & 0xff;
+		h *= 1099511628211ULL;
+	}
+	return h;
+}
+
+// Prepares a cache handle for the given instance. Returns false (and leaves
+// the handle unusable) if dir is NULL or the path does not fit.
+static bool cache_open(ResultCache *cache, const char *dir, const char *solver,
+		       const Task tasks[], int n, int K, int m)
+{
+	cache->sorted = NULL;
+	if (dir == NULL)
+		return false;
+
+	cache->sorted = (Task *)malloc((n > 0 ? n : 1) * sizeof(Task));
+	for (int i = 0; i < n; i++) {
+		cache->sorted[i] = tasks[i];
+		cache->sorted[i].is_in_S = tasks[i].is_in_S ? true : false;
+	}
+	qsort(cache->sorted, n, sizeof(Task), cache_compare_tasks);
+	cache->n = n;
+	cache->K = K;
+	cache->m = m;
+
+	uint64_t h = 14695981039346656037ULL;
+	h = cache_hash_int(h, n);
+	h = cache_hash_int(h, K);
+	h = cache_hash_int(h, m);
+	for (int i = 0; i < n; i++) {
+		h = cache_hash_int(h, cache->sorted[i].length);
+		h = cache_hash_int(h, cache->sorted[i].weight);
+		h = cache_hash_int(h, cache->sorted[i].deadline);
+		h = cache_hash_int(h, cache->sorted[i].is_in_S);
+	}
+
+	int len = snprintf(cache->path, sizeof(cache->path), "%s/%s-%016llx",
+			   dir, solver, (unsigned long long)h);
+	if (len < 0 || len >= (int)sizeof(cache->path) - 32) {
+		free(cache->sorted);
+		cache->sorted = NULL;
+		return false;
+	}
+	return true;
+}
+
+// Looks up the instance. On a hit, fills schedule[] with the caller's task
+// ids, machine[] (only read when m > 1) with the machine of each position
+// and *s_count with the stored S count, and returns true.
+static bool cache_lookup(const ResultCache *cache, int schedule[],
+			 int machine[], int *s_count)
+{
+	if (cache->sorted == NULL)
+		return false;
+
+	FILE *file = fopen(cache->path, "r");
+	if (file == NULL)
+		return false;
+
+	int n, K, m, count;
+	bool hit = fscanf(file, "%d %d %d", &n, &K, &m) == 3 &&
+		   n == cache->n && K == cache->K && m == cache->m;
+
+	for (int i = 0; hit && i < n; i++) {
+		int length, weight, deadline, is_in_S;
+		const Task *t = &cache->sorted[i];
+
+		hit = fscanf(file, "%d %d %d %d", &length, &weight, &deadline,
+			     &is_in_S) == 4 &&
+		      length == t->length && weight == t->weight &&
+		      deadline == t->deadline && is_in_S == t->is_in_S;
+	}
+
+	hit = hit && fscanf(file, "%d", &count) == 1;
+
+	for (int i = 0; hit && count != -1 && i < n; i++) {
+		int index;
+
+		hit = fscanf(file, "%d", &index) == 1 && index >= 0 &&
+		      index < n;
+		if (hit)
+			schedule[i] = cache->sorted[index].id;
+	}
+
+	for (int i = 0; hit && count != -1 && m > 1 && i < n; i++) {
+		hit = fscanf(file, "%d", &machine[i]) == 1 &&
+		      machine[i] >= 0 && machine[i] < m;
+	}
+
+	fclose(file);
+
+	if (hit)
+		*s_count = count;
+	return hit;
+}
+
+// Stores the result for the instance. Failures are silently ignored; the
+// cache is only an optimization.
+static void cache_store(const ResultCache *cache, const int schedule[],
+			const int machine[], int s_count)
+{
+	if (cache->sorted == NULL)
+		return;
+
+	int n = cache->n;
+	int *rank = (int *)malloc((n > 0 ? n : 1) * sizeof(int));
+	for (int i = 0; i < n; i++) {
+		rank[cache->sorted[i].id] = i;
+	}
+
+	char tmp_path[CACHE_PATH_MAX + 32];
+	snprintf(tmp_path, sizeof(tmp_path), "%s.tmp.%ld", cache->path,
+		 (long)getpid());
+
+	FILE *file = fopen(tmp_path, "w");
+	if (file == NULL) {
+		free(rank);
+		return;
+	}
+
+	fprintf(file, "%d %d %d\n", n, cache->K, cache->m);
+	for (int i = 0; i < n; i++) {
+		const Task *t = &cache->sorted[i];
+
+		fprintf(file, "%d %d %d %d\n", t->length, t->weight,
+			t->deadline, (int)t->is_in_S);
+	}
+	fprintf(file, "%d\n", s_count);
+	if (s_count != -1) {
+		for (int i = 0; i < n; i++) {
+			fprintf(file, "%d%s", rank[schedule[i]],
+				(i == n - 1) ? "" : " ");
+		}
+		fprintf(file, "\n");
+	}
+	if (s_count != -1 && cache->m > 1) {
+		for (int i = 0; i < n; i++) {
+			fprintf(file, "%d%s", machine[i],
+				(i == n - 1) ? "" : " ");
+		}
+		fprintf(file, "\n");
+	}
+
+	bool ok = !ferror(file);
+	ok = fclose(file) == 0 && ok;
+	if (!ok || rename(tmp_path, cache->path) != 0)
+		remove(tmp_path);
+
+	free(rank);
+}
+
+static void cache_close(ResultCache *cache)
+{
+	free(cache->sorted);
+	cache->sorted = NULL;
+}
+
+#endif
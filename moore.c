@@ -4,13 +4,8 @@
 #include <string.h>
 #include <time.h>
 
-typedef struct {
-    int id;
-    int length;
-    int weight;
-    int deadline;
-    bool is_in_S;
-} Task;
+#include "task.h"
+#include "cache.h"
 
 void print_schedule(Task tasks[], int schedule[], int n) {
     // printf("Schedule: ");
@@ -57,6 +52,21 @@ void print_schedule(Task tasks[], int schedule[], int n) {
     // printf("Number of S tasks completed on time: %d\n", s_on_time_count);
 }
 
+// Print one line per machine; schedule[] is grouped by machine in order
+void print_machine_schedule(int schedule[], int machine_of[], int n, int m) {
+    int i = 0;
+    for (int j = 0; j < m; j++) {
+        printf("Machine %d:", j);
+        if (i == n || machine_of[i] != j) {
+            printf(" (idle)");
+        }
+        for (bool first = true; i < n && machine_of[i] == j; i++, first = false) {
+            printf("%s%d", first ? " " : " -> ", schedule[i]);
+        }
+        printf("\n");
+    }
+}
+
 // Forward declaration of merge function
 void merge(Task** arr, int left, int mid, int right);
 
@@ -478,10 +488,206 @@ int* improved_moores_algorithm(Task tasks[], int n, int K, int *max_s_on_time) {
     return best_schedule;
 }
 
+// Min-heap of machine indices keyed by each machine's completion time,
+// ties going to the lower machine index
+bool machine_before(int a, int b, int load[]) {
+    return load[a] < load[b] || (load[a] == load[b] && a < b);
+}
+
+void machine_heap_sift_down(int heap[], int size, int pos, int load[]) {
+    while (2 * pos + 1 < size) {
+        int child = 2 * pos + 1;
+        if (child + 1 < size && machine_before(heap[child + 1], heap[child], load)) {
+            child++;
+        }
+        if (!machine_before(heap[child], heap[pos], load)) {
+            break;
+        }
+        int temp = heap[pos];
+        heap[pos] = heap[child];
+        heap[child] = temp;
+        pos = child;
+    }
+}
+
+void machine_heap_push(int heap[], int *size, int machine, int load[]) {
+    int pos = (*size)++;
+    heap[pos] = machine;
+    while (pos > 0 && machine_before(heap[pos], heap[(pos - 1) / 2], load)) {
+        int parent = (pos - 1) / 2;
+        int temp = heap[pos];
+        heap[pos] = heap[parent];
+        heap[parent] = temp;
+        pos = parent;
+    }
+}
+
+int machine_heap_pop(int heap[], int *size, int load[]) {
+    int top = heap[0];
+    heap[0] = heap[--(*size)];
+    machine_heap_sift_down(heap, *size, 0, load);
+    return top;
+}
+
+/**
+ * Moore's Algorithm on m Identical Parallel Machines
+ * Tasks are taken in EDD order and each one is appended to the machine that
+ * currently finishes first. If it would be late there, tasks are removed from
+ * that machine until it fits again; since every machine keeps its tasks in EDD
+ * order, removing a task never makes a later one late. Three removal rules are
+ * tried, mirroring the single machine strategies:
+ * 1. Longest task (classic Moore, maximizes on-time count)
+ * 2. Longest non-S task first, then the longest S task
+ * 3. Lightest task, to keep the tardy weight under K
+ * Removed tasks are then appended to the least loaded machines.
+ * The schedule lists machine 0's tasks first, then machine 1's, and so on;
+ * *machine_of receives the machine of each position.
+ */
+int* parallel_moores_algorithm(Task tasks[], int n, int m, int K, int *max_s_on_time, int **machine_of) {
+    Task** task_ptrs = (Task**)malloc(n * sizeof(Task*));
+    for (int i = 0; i < n; i++) {
+        task_ptrs[i] = &tasks[i];
+    }
+    
+    // Sort tasks by deadline (EDD - Earliest Due Date)
+    merge_sort_by_deadline(task_ptrs, 0, n-1);
+    
+    int* best_schedule = (int*)malloc(n * sizeof(int));
+    int* best_machine_of = (int*)malloc(n * sizeof(int));
+    int best_s_on_time = -1;
+    int best_tardy_weight = K + 1;
+    
+    int* assigned = (int*)malloc(n * sizeof(int)); // machine per EDD position, -1 if removed
+    bool* kept = (bool*)malloc(n * sizeof(bool)); // kept on time by Moore's pass
+    int* load = (int*)malloc(m * sizeof(int));
+    int* heap = (int*)malloc(m * sizeof(int));
+    int* schedule = (int*)malloc(n * sizeof(int));
+    int* schedule_machine = (int*)malloc(n * sizeof(int));
+    
+    for (int rule = 0; rule < 3; rule++) {
+        int heap_size = 0;
+        for (int j = 0; j < m; j++) {
+            load[j] = 0;
+            machine_heap_push(heap, &heap_size, j, load);
+        }
+        
+        for (int i = 0; i < n; i++) {
+            Task* task = task_ptrs[i];
+            int machine = machine_heap_pop(heap, &heap_size, load);
+            
+            assigned[i] = machine;
+            load[machine] += task->length;
+            
+            // While we're late for this task, drop a task from this machine
+            while (load[machine] > task->deadline) {
+                int to_remove_idx = -1;
+                
+                for (int k = 0; k <= i; k++) {
+                    if (assigned[k] != machine) {
+                        continue;
+                    }
+                    if (to_remove_idx == -1) {
+                        to_remove_idx = k;
+                        continue;
+                    }
+                    
+                    Task* candidate = task_ptrs[k];
+                    Task* chosen = task_ptrs[to_remove_idx];
+                    bool better;
+                    if (rule == 0) {
+                        better = candidate->length > chosen->length;
+                    } else if (rule == 1) {
+                        better = (chosen->is_in_S && !candidate->is_in_S) ||
+                                 (chosen->is_in_S == candidate->is_in_S &&
+                                  candidate->length > chosen->length);
+                    } else {
+                        better = candidate->weight < chosen->weight;
+                    }
+                    if (better) {
+                        to_remove_idx = k;
+                    }
+                }
+                if (to_remove_idx == -1) {
+                    break;
+                }
+                
+                load[machine] -= task_ptrs[to_remove_idx]->length;
+                assigned[to_remove_idx] = -1;
+            }
+            
+            machine_heap_push(heap, &heap_size, machine, load);
+        }
+        
+        // Then add tardy tasks to whichever machine frees up first
+        for (int i = 0; i < n; i++) {
+            kept[i] = assigned[i] != -1;
+            if (!kept[i]) {
+                int machine = machine_heap_pop(heap, &heap_size, load);
+                assigned[i] = machine;
+                load[machine] += task_ptrs[i]->length;
+                machine_heap_push(heap, &heap_size, machine, load);
+            }
+        }
+        
+        // Build the schedule machine by machine and evaluate it, with the
+        // tasks kept on time first and the tardy tasks after them
+        int s_on_time = 0;
+        int total_tardy_weight = 0;
+        int idx = 0;
+        
+        for (int j = 0; j < m; j++) {
+            int current_time = 0;
+            for (int pass = 0; pass < 2; pass++) {
+                for (int i = 0; i < n; i++) {
+                    if (assigned[i] != j || kept[i] != (pass == 0)) {
+                        continue;
+                    }
+                    Task* task = task_ptrs[i];
+                    current_time += task->length;
+                    
+                    if (current_time > task->deadline) {
+                        total_tardy_weight += task->weight;
+                    } else if (task->is_in_S) {
+                        s_on_time++;
+                    }
+                    
+                    schedule[idx] = task->id;
+                    schedule_machine[idx] = j;
+                    idx++;
+                }
+            }
+        }
+        
+        if (total_tardy_weight <= K && 
+            (s_on_time > best_s_on_time || 
+             (s_on_time == best_s_on_time && total_tardy_weight < best_tardy_weight))) {
+            best_s_on_time = s_on_time;
+            best_tardy_weight = total_tardy_weight;
+            memcpy(best_schedule, schedule, n * sizeof(int));
+            memcpy(best_machine_of, schedule_machine, n * sizeof(int));
+        }
+    }
+    
+    // Free allocated memory
+    free(task_ptrs);
+    free(assigned);
+    free(kept);
+    free(load);
+    free(heap);
+    free(schedule);
+    free(schedule_machine);
+    
+    // Set output parameters
+    *max_s_on_time = best_s_on_time;
+    *machine_of = best_machine_of;
+    
+    return best_schedule;
+}
+
 int main(int argc, char *argv[]) {
     // Check if filename is provided
-    if (argc != 2) {
-        printf("Usage: %s <path>\n", argv[0]);
+    if (argc != 2 && argc != 3) {
+        printf("Usage: %s <path> [cache_dir]\n", argv[0]);
         return 1;
     }
     
@@ -494,8 +700,15 @@ int main(int argc, char *argv[]) {
     
     int n; // Total number of tasks
     int K; // Tardy weight limit
+    int m = 1; // Number of identical machines (optional third header field)
     
-    fscanf(file, "%d %d", &n, &K);
+    char header[256];
+    if (fgets(header, sizeof(header), file) == NULL ||
+        sscanf(header, "%d %d %d", &n, &K, &m) < 2 || m < 1) {
+        printf("Invalid instance header: %s\n", argv[1]);
+        fclose(file);
+        return 1;
+    }
     
     Task *tasks = (Task *)malloc(n * sizeof(Task));
     for (int i = 0; i < n; i++) {
@@ -506,20 +719,40 @@ int main(int argc, char *argv[]) {
     
     fclose(file);
     
+    // Reuse a previous result for the same instance if a cache is given
+    ResultCache cache;
+    cache_open(&cache, argc == 3 ? argv[2] : NULL, "moore", tasks, n, K, m);
+    
+    int max_s_on_time = -1;
+    int *optimal_schedule = (int *)malloc(n * sizeof(int));
+    int *machine_of = (int *)calloc(n, sizeof(int));
+    bool cached = cache_lookup(&cache, optimal_schedule, machine_of, &max_s_on_time);
+    
     // Record time for performance analysis
     clock_t start, end;
     double cpu_time_used;
     
     start = clock();
     
-    int max_s_on_time = -1;
-    int *optimal_schedule = improved_moores_algorithm(tasks, n, K, &max_s_on_time);
+    if (!cached) {
+        free(optimal_schedule);
+        if (m == 1) {
+            optimal_schedule = improved_moores_algorithm(tasks, n, K, &max_s_on_time);
+        } else {
+            free(machine_of);
+            optimal_schedule = parallel_moores_algorithm(tasks, n, m, K, &max_s_on_time, &machine_of);
+        }
+        cache_store(&cache, optimal_schedule, machine_of, max_s_on_time);
+    }
     
     end = clock();
     cpu_time_used = ((double) (end - start)) / CLOCKS_PER_SEC;
     
     if (max_s_on_time == -1) {
         printf("No valid schedule found\n");
+    } else if (m > 1) {
+        printf("Solution found. Number of S tasks completed: %d\n", max_s_on_time);
+        print_machine_schedule(optimal_schedule, machine_of, n, m);
     } else {
         printf("Solution found. Number of S tasks completed: %d\n", max_s_on_time);
         printf("Optimal Schedule: ");
@@ -534,8 +767,10 @@ int main(int argc, char *argv[]) {
     
     // printf("\nExecution time: %f seconds\n", cpu_time_used);
     
+    cache_close(&cache);
     free(tasks);
     free(optimal_schedule);
+    free(machine_of);
     
     return 0;
 }
\ No newline at end of file
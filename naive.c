@@ -1,15 +1,11 @@
 #include <stdio.h>
 #include <stdbool.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <string.h>
 
-typedef struct {
-	int id;
-	int length;
-	int weight;
-	int deadline;
-	bool is_in_S;
-} Task;
+#include "task.h"
+#include "cache.h"
 
 void swap(int *a, int *b)
 {
@@ -115,11 +111,218 @@ void generate_permutations(Task tasks[], int n, int K)
 	free(nopts);
 }
 
+#define SMALL_N_MAX 16
+
+// Permutation search specialized for n <= SMALL_N_MAX. It is always inlined
+// into a switch on constant n, so every case gets its own copy with fixed
+// loop bounds that the compiler fully unrolls. Task fields live in stack
+// arrays and the tasks already placed are tracked in a 16-bit mask instead
+// of scanning the option stacks. Permutations are visited in the same
+// lexicographic order as generate_permutations, so the result is identical.
+static inline __attribute__((always_inline)) void
+generate_permutations_small(Task tasks[], const int n, int K)
+{
+	int length[SMALL_N_MAX], weight[SMALL_N_MAX], deadline[SMALL_N_MAX];
+	bool is_in_S[SMALL_N_MAX];
+	int perm[SMALL_N_MAX];
+	int next[SMALL_N_MAX + 1]; // lowest candidate left to try per depth
+	const uint32_t all = (1u << n) - 1;
+	uint16_t used = 0;
+	int depth = 0;
+
+	for (int i = 0; i < n; i++) {
+		length[i] = tasks[i].length;
+		weight[i] = tasks[i].weight;
+		deadline[i] = tasks[i].deadline;
+		is_in_S[i] = tasks[i].is_in_S;
+	}
+
+	next[0] = 0;
+	while (depth >= 0) {
+		if (depth == n) { // solution found!
+			int current_time = 0;
+			int total_tardy_weight = 0;
+			int s_on_time_count = 0;
+
+#pragma GCC unroll 16
+			for (int i = 0; i < n; i++) {
+				int task_index = perm[i];
+
+				current_time += length[task_index];
+				if (current_time > deadline[task_index])
+					total_tardy_weight += weight[task_index];
+				else
+					s_on_time_count += is_in_S[task_index];
+			}
+
+			if (total_tardy_weight <= K &&
+			    s_on_time_count > max_s_on_time_count) {
+				max_s_on_time_count = s_on_time_count;
+				memcpy(optimal_permutation, perm, n * sizeof(int));
+			}
+		} else {
+			uint32_t avail = all & ~(uint32_t)used &
+					~((1u << next[depth]) - 1);
+
+			if (avail != 0) {
+				int candidate = __builtin_ctz(avail);
+
+				perm[depth] = candidate;
+				used |= (uint16_t)(1u << candidate);
+				next[depth] = candidate + 1;
+				next[++depth] = 0;
+				continue;
+			}
+		}
+
+		// Backtrack
+		if (--depth >= 0)
+			used &= (uint16_t)~(1u << perm[depth]);
+	}
+}
+
+#define SMALL_CASE(N)                                    \
+	case N:                                          \
+		generate_permutations_small(tasks, N, K); \
+		return true;
+
+// Runs the specialized kernel for n. Returns false if n is too large.
+bool generate_permutations_dispatch(Task tasks[], int n, int K)
+{
+	switch (n) {
+		SMALL_CASE(0)
+		SMALL_CASE(1)
+		SMALL_CASE(2)
+		SMALL_CASE(3)
+		SMALL_CASE(4)
+		SMALL_CASE(5)
+		SMALL_CASE(6)
+		SMALL_CASE(7)
+		SMALL_CASE(8)
+		SMALL_CASE(9)
+		SMALL_CASE(10)
+		SMALL_CASE(11)
+		SMALL_CASE(12)
+		SMALL_CASE(13)
+		SMALL_CASE(14)
+		SMALL_CASE(15)
+		SMALL_CASE(16)
+	default:
+		return false;
+	}
+}
+
+#undef SMALL_CASE
+
+int *optimal_machine; // machine of each position in optimal_permutation
+
+// State of the search over schedules on m identical machines
+typedef struct {
+	Task *tasks;
+	int n; // number of tasks
+	int m; // number of machines
+	int K; // tardy weight limit
+	int *perm; // tasks placed so far, grouped by machine
+	int *machine; // machine of each position in perm
+	bool *used;
+} MachineSearch;
+
+// placed = number of tasks in perm
+// j = machine currently being filled
+// first = first task on machine j (-1 while it is empty)
+// prev_first = first task on machine j - 1 (-1 for machine 0)
+//
+// Machines are identical, so any schedule can be relabelled to put the
+// machines in increasing order of their first task, with idle machines last.
+// Only that labelling is generated: machine j can only be opened with a task
+// larger than the first task of machine j - 1, and a machine is only closed
+// once it has a task. Branches are cut as soon as the tardy weight exceeds K.
+void extend_machine_schedule(MachineSearch *s, int placed, int j, int first,
+			     int prev_first, int current_time,
+			     int total_tardy_weight, int s_on_time_count)
+{
+	if (placed == s->n) { // solution found!
+		if (s_on_time_count > max_s_on_time_count) {
+			max_s_on_time_count = s_on_time_count;
+			memcpy(optimal_permutation, s->perm, s->n * sizeof(int));
+			memcpy(optimal_machine, s->machine, s->n * sizeof(int));
+		}
+		return;
+	}
+
+	for (int t = 0; t < s->n; t++) {
+		if (s->used[t] || (first == -1 && t < prev_first))
+			continue;
+
+		Task current_task = s->tasks[t];
+		int completion_time = current_time + current_task.length;
+		int tardy_weight = total_tardy_weight;
+		int s_count = s_on_time_count;
+
+		if (completion_time > current_task.deadline) {
+			// Task is tardy
+			tardy_weight += current_task.weight;
+			if (tardy_weight > s->K)
+				continue;
+		} else if (current_task.is_in_S) {
+			s_count++;
+		}
+
+		s->used[t] = true;
+		s->perm[placed] = t;
+		s->machine[placed] = j;
+		extend_machine_schedule(s, placed + 1, j, first == -1 ? t : first,
+					prev_first, completion_time,
+					tardy_weight, s_count);
+		s->used[t] = false;
+	}
+
+	// Close machine j and start filling the next one
+	if (first != -1 && j + 1 < s->m)
+		extend_machine_schedule(s, placed, j + 1, -1, first, 0,
+					total_tardy_weight, s_on_time_count);
+}
+
+// tasks = task list
+// n = number of tasks
+// m = number of machines
+// K = tardy weight limit
+void generate_machine_schedules(Task tasks[], int n, int m, int K)
+{
+	MachineSearch s = { tasks, n, m, K };
+
+	s.perm = (int *)malloc((n > 0 ? n : 1) * sizeof(int));
+	s.machine = (int *)malloc((n > 0 ? n : 1) * sizeof(int));
+	s.used = (bool *)calloc(n > 0 ? n : 1, sizeof(bool));
+
+	extend_machine_schedule(&s, 0, 0, -1, -1, 0, 0, 0);
+
+	free(s.perm);
+	free(s.machine);
+	free(s.used);
+}
+
+// Print one line per machine; schedule[] is grouped by machine in order
+void print_machine_schedule(int schedule[], int machine_of[], int n, int m)
+{
+	int i = 0;
+
+	for (int j = 0; j < m; j++) {
+		printf("Machine %d:", j);
+		if (i == n || machine_of[i] != j)
+			printf(" (idle)");
+		for (bool first = true; i < n && machine_of[i] == j;
+		     i++, first = false)
+			printf("%s%d", first ? " " : " -> ", schedule[i]);
+		printf("\n");
+	}
+}
+
 int main(int argc, char *argv[])
 {
 	// Check if filename is provided
-	if (argc != 2) {
-		printf("Usage: %s <path>\n", argv[0]);
+	if (argc != 2 && argc != 3) {
+		printf("Usage: %s <path> [cache_dir]\n", argv[0]);
 		return 1;
 	}
 
@@ -128,8 +331,16 @@ int main(int argc, char *argv[])
 
 	int n; // Total number of tasks
 	int K; // Tardy weight limit
+	int m = 1; // Number of identical machines (optional third header field)
 
-	fscanf(file, "%d %d", &n, &K);
+	char header[256];
+	if (file == NULL || fgets(header, sizeof(header), file) == NULL ||
+	    sscanf(header, "%d %d %d", &n, &K, &m) < 2 || m < 1) {
+		printf("Invalid instance header: %s\n", argv[1]);
+		if (file != NULL)
+			fclose(file);
+		return 1;
+	}
 
 	Task *tasks = (Task *)malloc(n * sizeof(Task));
 	for (int i = 0; i < n; i++) {
@@ -141,11 +352,30 @@ int main(int argc, char *argv[])
 	fclose(file);
 
 	optimal_permutation = (int *)malloc(n * sizeof(int));
+	optimal_machine = (int *)calloc(n, sizeof(int));
 
-	generate_permutations(tasks, n, K);
+	// Reuse a previous result for the same instance if a cache is given
+	ResultCache cache;
+	cache_open(&cache, argc == 3 ? argv[2] : NULL, "naive", tasks, n, K, m);
+
+	if (!cache_lookup(&cache, optimal_permutation, optimal_machine,
+			  &max_s_on_time_count)) {
+		if (m > 1)
+			generate_machine_schedules(tasks, n, m, K);
+		else if (!generate_permutations_dispatch(tasks, n, K))
+			generate_permutations(tasks, n, K);
+		cache_store(&cache, optimal_permutation, optimal_machine,
+			    max_s_on_time_count);
+	}
+	cache_close(&cache);
 
 	if (max_s_on_time_count == -1) {
 		printf("No valid schedule found\n");
+	} else if (m > 1) {
+		printf("Solution found. Number of S tasks completed: %d\n",
+		       max_s_on_time_count);
+		print_machine_schedule(optimal_permutation, optimal_machine, n,
+				       m);
 	} else {
 		printf("Solution found. Number of S tasks completed: %d\n",
 		       max_s_on_time_count);
@@ -159,4 +389,5 @@ int main(int argc, char *argv[])
 
 	free(tasks);
 	free(optimal_permutation);
+	free(optimal_machine);
 }
\ No newline at end of file
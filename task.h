@@ -0,0 +1,14 @@
+#ifndef TASK_H
+#define TASK_H
+
+#include <stdbool.h>
+
+typedef struct {
+	int id;
+	int length;
+	int weight;
+	int deadline;
+	bool is_in_S;
+} Task;
+
+#endif